@@ -0,0 +1,30 @@
+#pragma once
+
+#include "chessbotcore_global.h"
+
+#include <cstddef>
+
+/**
+ * @brief Test instrumentation that observes heap allocations.
+ *
+ * Only compiled when CHESSBOT_ALLOCATION_HOOK is defined, which the Debug
+ * configuration used by ChessBotTests does; release builds ship without it.
+ * The library then replaces the global operator new family with versions
+ * that report every allocation to the installed callback. On Windows the
+ * replacement only covers ChessBotCore.dll itself, which is what lets the
+ * tests see allocations made inside the library. On ELF platforms it
+ * becomes the allocator of the whole process, so allocations made by the
+ * caller are reported too.
+ */
+#ifdef CHESSBOT_ALLOCATION_HOOK
+namespace AllocationHook
+{
+    using Callback = void (*)(std::size_t size);
+
+    /** @brief Installs @p callback, or removes the current one with nullptr. */
+    CHESSBOTCORE_EXPORT void install(Callback callback);
+
+    /** @brief Allocates and frees @p size bytes inside the library. */
+    CHESSBOTCORE_EXPORT void probe(std::size_t size);
+}
+#endif
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+/**
+ * @brief Log-linear latency histogram in the style of HdrHistogram.
+ *
+ * Values are bucketed by power of two and each power is split into
+ * 2^kSubBucketBits linear sub-buckets, which bounds the relative error of
+ * every reported value to about 3% over the full 64-bit range. All counters
+ * are relaxed atomics, so any thread may record while another one reads a
+ * report.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr std::size_t kSubBuckets = std::size_t(1) << kSubBucketBits;
+    static constexpr std::size_t kBucketCount = kSubBuckets * (65 - kSubBucketBits);
+
+    /**
+     * @brief Records one sample, in microseconds.
+     *
+     * Bumps the sample's bucket and the total count, then raises the
+     * maximum with a compare-and-swap loop if needed.
+     */
+    void record(std::uint64_t micros)
+    {
+        m_buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+
+        std::uint64_t previous = m_max.load(std::memory_order_relaxed);
+        while (micros > previous && !m_max.compare_exchange_weak(previous, micros, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void reset()
+    {
+        for (auto& bucket : m_buckets)
+            bucket.store(0, std::memory_order_relaxed);
+        m_count.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    std::uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    std::uint64_t max() const { return m_max.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Upper bound of the bucket holding the sample at @p percentile,
+     * capped at max(); 0 if the histogram is empty.
+     *
+     * The result is at least the exact percentile value and at most ~3%
+     * above it. Values below kSubBuckets are exact.
+     */
+    std::uint64_t valueAtPercentile(double percentile) const
+    {
+        const std::uint64_t total = count();
+        if (total == 0)
+            return 0;
+
+        const double clamped = percentile < 0.0 ? 0.0 : (percentile > 100.0 ? 100.0 : percentile);
+        std::uint64_t target = static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * double(total)));
+        if (target == 0)
+            target = 1;
+
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i)
+        {
+            seen += m_buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target)
+            {
+                const std::uint64_t upper = bucketUpperBound(i);
+                const std::uint64_t highest = max();
+                return upper < highest ? upper : highest;
+            }
+        }
+        return max();
+    }
+
+    /** @brief One-line summary: count, p50, p90, p99, p99.9 and max. */
+    std::string summary() const
+    {
+        std::ostringstream out;
+        out << "count " << count()
+            << " p50 " << valueAtPercentile(50.0)
+            << " p90 " << valueAtPercentile(90.0)
+            << " p99 " << valueAtPercentile(99.0)
+            << " p99.9 " << valueAtPercentile(99.9)
+            << " max " << max() << " us";
+        return out.str();
+    }
+
+    /** @brief Index of the bucket that @p value falls into. */
+    static constexpr std::size_t bucketIndex(std::uint64_t value)
+    {
+        if (value < kSubBuckets)
+            return static_cast<std::size_t>(value);
+
+        // Leading bit at position msb; the next kSubBucketBits bits pick the sub-bucket.
+        const int msb = std::bit_width(value) - 1;
+        const int shift = msb - kSubBucketBits;
+        const std::size_t subBucket = static_cast<std::size_t>(value >> shift) & (kSubBuckets - 1);
+        return kSubBuckets + static_cast<std::size_t>(shift) * kSubBuckets + subBucket;
+    }
+
+    /** @brief Largest value that falls into bucket @p index. */
+    static constexpr std::uint64_t bucketUpperBound(std::size_t index)
+    {
+        if (index < kSubBuckets)
+            return index;
+
+        const std::size_t shift = (index - kSubBuckets) / kSubBuckets;
+        const std::uint64_t subBucket = (index - kSubBuckets) % kSubBuckets;
+        const std::uint64_t lower = (kSubBuckets + subBucket) << shift;
+        return lower + ((std::uint64_t(1) << shift) - 1);
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBucketCount> m_buckets{};
+    std::atomic<std::uint64_t> m_count{ 0 };
+    std::atomic<std::uint64_t> m_max{ 0 };
+};
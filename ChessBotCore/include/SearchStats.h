@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+/**
+ * @brief Counters collected by a search thread.
+ */
+enum class SearchStat : std::size_t
+{
+    Nodes,
+    QNodes,
+    TTHits,
+    TTCutoffs,
+    NullMoveTries,
+    NullMoveCutoffs,
+    LmrResearches,
+    BetaCutoffs,
+    FirstMoveCutoffs,
+    EvalCalls,
+    Count
+};
+
+/**
+ * @brief Per-thread search statistics.
+ *
+ * Each search thread owns one instance and is the only writer of it;
+ * instances are only summed when a report is produced. Counters are atomics
+ * bumped with a relaxed load and store rather than a locked read-modify-write,
+ * which compiles to a plain add on x86 yet lets other threads read them
+ * mid-search, e.g. for NPS output or node limits. The object is aligned to a
+ * cache line so neighbouring threads never share one. With
+ * @p Enabled set to false every member is an empty inline function and the
+ * counters cost nothing.
+ */
+template <bool Enabled>
+class SearchStats;
+
+template <>
+class alignas(64) SearchStats<true>
+{
+public:
+    static constexpr bool enabled = true;
+
+    SearchStats() = default;
+    SearchStats(const SearchStats& other) { *this = other; }
+
+    SearchStats& operator=(const SearchStats& other)
+    {
+        for (std::size_t i = 0; i < m_counters.size(); ++i)
+            m_counters[i].store(other.m_counters[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    /** @brief Adds @p n to a counter; only the owning thread may call this. */
+    void add(SearchStat stat, std::uint64_t n = 1)
+    {
+        std::atomic<std::uint64_t>& counter = m_counters[index(stat)];
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::uint64_t get(SearchStat stat) const { return m_counters[index(stat)].load(std::memory_order_relaxed); }
+
+    /** @brief Zeroes every counter; only the owning thread may call this. */
+    void reset()
+    {
+        for (auto& counter : m_counters)
+            counter.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Share of beta cutoffs produced by the first move searched.
+     */
+    double firstMoveCutoffRate() const
+    {
+        const std::uint64_t cutoffs = get(SearchStat::BetaCutoffs);
+        return cutoffs ? double(get(SearchStat::FirstMoveCutoffs)) / double(cutoffs) : 0.0;
+    }
+
+    SearchStats& operator+=(const SearchStats& other)
+    {
+        for (std::size_t i = 0; i < m_counters.size(); ++i)
+            add(static_cast<SearchStat>(i), other.m_counters[i].load(std::memory_order_relaxed));
+        return *this;
+    }
+
+private:
+    static constexpr std::size_t index(SearchStat stat) { return static_cast<std::size_t>(stat); }
+
+    std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(SearchStat::Count)> m_counters{};
+};
+
+template <>
+class SearchStats<false>
+{
+public:
+    static constexpr bool enabled = false;
+
+    void add(SearchStat, std::uint64_t = 1) {}
+    std::uint64_t get(SearchStat) const { return 0; }
+    void reset() {}
+    double firstMoveCutoffRate() const { return 0.0; }
+    SearchStats& operator+=(const SearchStats&) { return *this; }
+};
+
+/**
+ * @brief Sums the statistics of every thread into a single report.
+ *
+ * The statistics type is taken from the element type of @p perThread. May
+ * run while the search threads are still counting; each counter is then read
+ * at some point during the call.
+ */
+template <typename Range>
+auto aggregateSearchStats(const Range& perThread)
+{
+    using Stats = std::remove_cvref_t<decltype(*std::begin(perThread))>;
+
+    Stats total;
+    for (const Stats& stats : perThread)
+        total += stats;
+    return total;
+}
+
+#ifndef CHESSBOT_SEARCH_STATS
+# define CHESSBOT_SEARCH_STATS 0
+#endif
+
+/**
+ * @brief Statistics type used by the search, selected at build time with
+ * CHESSBOT_SEARCH_STATS.
+ */
+using ThreadSearchStats = SearchStats<CHESSBOT_SEARCH_STATS != 0>;
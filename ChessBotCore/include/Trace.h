@@ -0,0 +1,90 @@
+#pragma once
+
+#include "chessbotcore_global.h"
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Lightweight event tracer exported in Chrome trace (Perfetto) format.
+ *
+ * Every thread records into its own fixed-size buffer, so recording never
+ * locks or allocates after the first event of a thread. Once a buffer holds
+ * kEventsPerThread events, later events of that thread are dropped: the
+ * start of a search is what matters, so call clear() when a search starts.
+ * Event names must be string literals: only the pointer is stored. A thread
+ * hands its buffer back when it exits and the next new thread continues it,
+ * so memory is bounded by the number of threads recording at once.
+ *
+ * Setting the CHESSBOT_TRACE_FILE environment variable exports the trace to
+ * that path when the process exits.
+ *
+ * Use the CHESSBOT_TRACE_* macros rather than calling this class directly;
+ * they compile to nothing unless CHESSBOT_TRACE is defined.
+ */
+class CHESSBOTCORE_EXPORT Trace
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t kEventsPerThread = 1 << 14;
+
+    /**
+     * @brief Records a complete event spanning [begin, end).
+     *
+     * A negative duration is recorded as zero.
+     */
+    static void complete(const char* name, Clock::time_point begin, Clock::time_point end);
+
+    /** @brief Records a zero-duration event, e.g. a thread wake-up. */
+    static void instant(const char* name);
+
+    /**
+     * @brief Writes all recorded events to @p path as Chrome trace JSON.
+     *
+     * May run while other threads are still recording; events they record
+     * during the export may or may not be included.
+     * @return false if the file could not be written.
+     */
+    static bool exportChromeJson(const std::string& path);
+
+    /**
+     * @brief Drops all recorded events.
+     *
+     * Safe to call while other threads record: each thread empties its own
+     * buffer the next time it records.
+     */
+    static void clear();
+};
+
+/**
+ * @brief Records a complete event covering the lifetime of the object.
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name)
+        : m_name(name), m_begin(Trace::Clock::now())
+    {}
+
+    ~TraceScope() { Trace::complete(m_name, m_begin, Trace::Clock::now()); }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    Trace::Clock::time_point m_begin;
+};
+
+#define CHESSBOT_TRACE_CONCAT_IMPL(a, b) a##b
+#define CHESSBOT_TRACE_CONCAT(a, b) CHESSBOT_TRACE_CONCAT_IMPL(a, b)
+
+#ifdef CHESSBOT_TRACE
+# define CHESSBOT_TRACE_SCOPE(name) const TraceScope CHESSBOT_TRACE_CONCAT(traceScope_, __LINE__)(name)
+# define CHESSBOT_TRACE_INSTANT(name) Trace::instant(name)
+#else
+# define CHESSBOT_TRACE_SCOPE(name) ((void)0)
+# define CHESSBOT_TRACE_INSTANT(name) ((void)0)
+#endif
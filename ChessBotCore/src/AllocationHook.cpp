@@ -0,0 +1,97 @@
+#include "AllocationHook.h"
+
+#ifdef CHESSBOT_ALLOCATION_HOOK
+
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+namespace
+{
+    std::atomic<AllocationHook::Callback> g_callback{ nullptr };
+
+    void notify(std::size_t size)
+    {
+        if (const AllocationHook::Callback callback = g_callback.load(std::memory_order_relaxed))
+            callback(size);
+    }
+
+    // Retries through the installed new-handler as [new.delete.single] requires.
+    template <typename Allocator>
+    void* allocateOrThrow(Allocator tryAllocate)
+    {
+        for (;;)
+        {
+            if (void* p = tryAllocate())
+                return p;
+
+            const std::new_handler handler = std::get_new_handler();
+            if (!handler)
+                throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    void* allocate(std::size_t size)
+    {
+        notify(size);
+        const std::size_t bytes = size ? size : 1;
+        return allocateOrThrow([bytes] { return std::malloc(bytes); });
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        notify(size);
+        const std::size_t align = static_cast<std::size_t>(alignment);
+        const std::size_t bytes = size ? size : 1;
+        if (bytes > std::numeric_limits<std::size_t>::max() - (align - 1))
+            throw std::bad_alloc();
+
+        const std::size_t rounded = (bytes + align - 1) / align * align;
+        return allocateOrThrow([rounded, align] {
+#ifdef _MSC_VER
+            return _aligned_malloc(rounded, align);
+#else
+            return std::aligned_alloc(align, rounded);
+#endif
+        });
+    }
+
+    void deallocateAligned(void* p) noexcept
+    {
+#ifdef _MSC_VER
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+void AllocationHook::install(Callback callback)
+{
+    g_callback.store(callback, std::memory_order_seq_cst);
+}
+
+void AllocationHook::probe(std::size_t size)
+{
+    // Calling the allocation function directly, rather than through a
+    // new-expression, cannot be optimised away.
+    ::operator delete(::operator new(size));
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { deallocateAligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { deallocateAligned(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { deallocateAligned(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { deallocateAligned(p); }
+
+#endif
@@ -0,0 +1,197 @@
+#include "Trace.h"
+
+#include <QtCore/qbytearray.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t kEventsPerThread = Trace::kEventsPerThread;
+
+    // Bumped by Trace::clear(); a buffer recorded under an older generation is stale.
+    std::atomic<std::uint64_t> g_generation{ 0 };
+
+    // Fields are relaxed atomics so an export may run while threads record.
+    struct TraceEvent
+    {
+        std::atomic<const char*> name;
+        std::atomic<std::int64_t> beginUs;
+        std::atomic<std::uint32_t> durationUs;
+        std::atomic<char> phase; // 'X' complete, 'i' instant.
+    };
+
+    struct ThreadBuffer
+    {
+        std::uint32_t threadId = 0;
+        std::atomic<std::uint64_t> generation{ 0 };
+        std::atomic<std::size_t> written{ 0 }; // Published with release after each event.
+        std::array<TraceEvent, kEventsPerThread> events{};
+
+        void push(const char* name, std::int64_t beginUs, std::uint32_t durationUs, char phase)
+        {
+            const std::uint64_t current = g_generation.load(std::memory_order_acquire);
+            std::size_t count = written.load(std::memory_order_relaxed);
+            if (generation.load(std::memory_order_relaxed) != current)
+            {
+                generation.store(current, std::memory_order_relaxed);
+                count = 0;
+            }
+            if (count >= kEventsPerThread)
+                return;
+
+            TraceEvent& event = events[count];
+            event.name.store(name, std::memory_order_relaxed);
+            event.beginUs.store(beginUs, std::memory_order_relaxed);
+            event.durationUs.store(durationUs, std::memory_order_relaxed);
+            event.phase.store(phase, std::memory_order_relaxed);
+            written.store(count + 1, std::memory_order_release);
+        }
+    };
+
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        std::vector<ThreadBuffer*> freeBuffers; // Left behind by exited threads.
+    };
+
+    // Captured at library load so that no recorded event precedes it.
+    const Trace::Clock::time_point g_origin = Trace::Clock::now();
+
+    // Never destroyed, so threads still recording during exit and the atexit
+    // export never see a dead registry.
+    Registry& registry()
+    {
+        static Registry* instance = new Registry;
+        return *instance;
+    }
+
+    // Hands the thread's buffer back to the registry when the thread exits.
+    // The next thread reuses it and appends to its events, so memory is
+    // bounded by the number of threads alive at once.
+    struct BufferLease
+    {
+        ThreadBuffer* buffer = nullptr;
+
+        ~BufferLease()
+        {
+            if (!buffer)
+                return;
+            Registry& reg = registry();
+            const std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.freeBuffers.push_back(buffer);
+        }
+    };
+
+    ThreadBuffer& localBuffer()
+    {
+        thread_local BufferLease lease;
+        if (!lease.buffer)
+        {
+            Registry& reg = registry();
+            const std::lock_guard<std::mutex> lock(reg.mutex);
+            if (!reg.freeBuffers.empty())
+            {
+                lease.buffer = reg.freeBuffers.back();
+                reg.freeBuffers.pop_back();
+            }
+            else
+            {
+                reg.buffers.push_back(std::make_unique<ThreadBuffer>());
+                // Keeps the push_back in ~BufferLease from allocating.
+                reg.freeBuffers.reserve(reg.buffers.size());
+                lease.buffer = reg.buffers.back().get();
+                lease.buffer->threadId = static_cast<std::uint32_t>(reg.buffers.size());
+            }
+        }
+        return *lease.buffer;
+    }
+
+    std::int64_t sinceOrigin(Trace::Clock::time_point t)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(t - g_origin).count();
+    }
+
+    void writeEscaped(std::ofstream& out, const char* text)
+    {
+        for (const char* c = text; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+                out << '\\';
+            out << *c;
+        }
+    }
+
+    bool installExitExport()
+    {
+        if (qEnvironmentVariableIsEmpty("CHESSBOT_TRACE_FILE"))
+            return false;
+
+        std::atexit([] { Trace::exportChromeJson(qgetenv("CHESSBOT_TRACE_FILE").toStdString()); });
+        return true;
+    }
+
+    [[maybe_unused]] const bool g_exportAtExit = installExitExport();
+}
+
+void Trace::complete(const char* name, Clock::time_point begin, Clock::time_point end)
+{
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    const std::uint32_t durationUs = duration <= 0 ? 0u
+        : static_cast<std::uint32_t>(duration < 0xFFFFFFFF ? duration : 0xFFFFFFFF);
+    localBuffer().push(name, sinceOrigin(begin), durationUs, 'X');
+}
+
+void Trace::instant(const char* name)
+{
+    localBuffer().push(name, sinceOrigin(Clock::now()), 0, 'i');
+}
+
+bool Trace::exportChromeJson(const std::string& path)
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+        return false;
+
+    Registry& reg = registry();
+    const std::lock_guard<std::mutex> lock(reg.mutex);
+
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    const std::uint64_t current = g_generation.load(std::memory_order_acquire);
+    for (const auto& buffer : reg.buffers)
+    {
+        if (buffer->generation.load(std::memory_order_relaxed) != current)
+            continue;
+
+        const std::size_t count = buffer->written.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const TraceEvent& event = buffer->events[i];
+            const std::int64_t beginUs = event.beginUs.load(std::memory_order_relaxed);
+
+            out << (first ? "\n" : ",\n") << "{\"name\":\"";
+            writeEscaped(out, event.name.load(std::memory_order_relaxed));
+            out << "\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"ts\":" << beginUs;
+            if (event.phase.load(std::memory_order_relaxed) == 'i')
+                out << ",\"ph\":\"i\",\"s\":\"t\"}";
+            else
+                out << ",\"ph\":\"X\",\"dur\":" << event.durationUs.load(std::memory_order_relaxed) << "}";
+            first = false;
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return static_cast<bool>(out);
+}
+
+void Trace::clear()
+{
+    g_generation.fetch_add(1, std::memory_order_acq_rel);
+}
@@ -0,0 +1,37 @@
+#include "pch.h"
+#include "AllocationTracker.h"
+#include "AllocationHook.h"
+
+#include <atomic>
+
+namespace
+{
+    std::atomic<std::uint64_t> g_allocations{ 0 };
+
+#ifdef CHESSBOT_ALLOCATION_HOOK
+    void countAllocation(std::size_t)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+}
+
+void AllocationTracker::start()
+{
+    g_allocations.store(0, std::memory_order_relaxed);
+#ifdef CHESSBOT_ALLOCATION_HOOK
+    AllocationHook::install(&countAllocation);
+#endif
+}
+
+void AllocationTracker::stop()
+{
+#ifdef CHESSBOT_ALLOCATION_HOOK
+    AllocationHook::install(nullptr);
+#endif
+}
+
+std::uint64_t AllocationTracker::allocations()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
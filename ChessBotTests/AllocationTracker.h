@@ -0,0 +1,33 @@
+#pragma once
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+//
+// Counts heap allocations made inside ChessBotCore, through the hook the
+// library exports when built with CHESSBOT_ALLOCATION_HOOK (see
+// AllocationHook.h). Counting is off by default and only covers the code
+// between start() and stop(). Tests using the fixture are skipped in
+// configurations without the hook.
+//
+
+namespace AllocationTracker
+{
+    void start();
+    void stop();
+    std::uint64_t allocations();
+}
+
+class ZeroAllocationTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+#ifndef CHESSBOT_ALLOCATION_HOOK
+        GTEST_SKIP() << "ChessBotCore was built without CHESSBOT_ALLOCATION_HOOK";
+#endif
+    }
+
+    void TearDown() override { AllocationTracker::stop(); }
+};
@@ -1,7 +1,233 @@
 #include "pch.h"
 #include "ChessBotCore.h"
+#include "AllocationHook.h"
+#include "AllocationTracker.h"
+#include "LatencyHistogram.h"
+#include "SearchStats.h"
+#include "Trace.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 TEST(TestCaseName, TestName) {
   EXPECT_EQ(1, 1);
   EXPECT_TRUE(true);
 }
+
+#ifdef CHESSBOT_ALLOCATION_HOOK
+TEST_F(ZeroAllocationTest, CountsAllocationsMadeInsideCore) {
+  AllocationTracker::start();
+  AllocationHook::probe(16);
+  AllocationTracker::stop();
+  EXPECT_EQ(1u, AllocationTracker::allocations());
+}
+
+TEST_F(ZeroAllocationTest, StopsCountingAfterStop) {
+  AllocationTracker::start();
+  AllocationTracker::stop();
+  AllocationHook::probe(16);
+  EXPECT_EQ(0u, AllocationTracker::allocations());
+}
+#endif
+
+TEST_F(ZeroAllocationTest, TraceRecordingDoesNotAllocate) {
+  Trace::instant("warm-up");
+
+  AllocationTracker::start();
+  const Trace::Clock::time_point begin = Trace::Clock::now();
+  for (int i = 0; i < 100; ++i) {
+    Trace::instant("wake");
+    Trace::complete("iteration", begin, Trace::Clock::now());
+  }
+  Trace::clear();
+  Trace::instant("after clear");
+  AllocationTracker::stop();
+  EXPECT_EQ(0u, AllocationTracker::allocations());
+}
+
+TEST(SearchStatsTest, EnabledCountersAggregateAcrossThreads) {
+  std::vector<SearchStats<true>> perThread(3);
+  perThread[0].add(SearchStat::Nodes, 10);
+  perThread[1].add(SearchStat::Nodes, 5);
+  perThread[2].add(SearchStat::BetaCutoffs, 4);
+  perThread[2].add(SearchStat::FirstMoveCutoffs, 3);
+
+  const SearchStats<true> total = aggregateSearchStats(perThread);
+  EXPECT_EQ(15u, total.get(SearchStat::Nodes));
+  EXPECT_EQ(0u, total.get(SearchStat::QNodes));
+  EXPECT_DOUBLE_EQ(0.75, total.firstMoveCutoffRate());
+  EXPECT_EQ(0u, sizeof(SearchStats<true>) % 64);
+}
+
+TEST(SearchStatsTest, DisabledCountersAlwaysReadZero) {
+  std::vector<SearchStats<false>> perThread(2);
+  perThread[0].add(SearchStat::Nodes, 10);
+  perThread[1].add(SearchStat::EvalCalls);
+
+  const SearchStats<false> total = aggregateSearchStats(perThread);
+  EXPECT_EQ(0u, total.get(SearchStat::Nodes));
+  EXPECT_EQ(0u, total.get(SearchStat::EvalCalls));
+  EXPECT_DOUBLE_EQ(0.0, total.firstMoveCutoffRate());
+}
+
+TEST(SearchStatsTest, AggregatesWhileThreadsAreCounting) {
+  std::vector<SearchStats<true>> perThread(2);
+  std::atomic<bool> stop{ false };
+  std::thread worker([&] {
+    while (!stop.load(std::memory_order_relaxed))
+      perThread[1].add(SearchStat::Nodes);
+  });
+
+  std::uint64_t previous = 0;
+  for (int i = 0; i < 100; ++i) {
+    const std::uint64_t nodes = aggregateSearchStats(perThread).get(SearchStat::Nodes);
+    EXPECT_GE(nodes, previous);
+    previous = nodes;
+  }
+  stop.store(true, std::memory_order_relaxed);
+  worker.join();
+  EXPECT_GE(aggregateSearchStats(perThread).get(SearchStat::Nodes), previous);
+}
+
+namespace {
+  std::string exportTrace() {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "chessbot_trace_test.json";
+    EXPECT_TRUE(Trace::exportChromeJson(path.string()));
+    std::ifstream in(path);
+    std::stringstream json;
+    json << in.rdbuf();
+    in.close();
+    std::filesystem::remove(path);
+    return json.str();
+  }
+}
+
+TEST(TraceTest, ExportsChromeTraceJson) {
+  Trace::clear();
+  const Trace::Clock::time_point begin = Trace::Clock::now();
+  Trace::complete("iteration", begin, begin + std::chrono::microseconds(250));
+  Trace::instant("wake \"main\"");
+
+  const std::string json = exportTrace();
+  EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"iteration\""));
+  EXPECT_NE(std::string::npos, json.find("\"ph\":\"X\",\"dur\":250"));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"wake \\\"main\\\"\""));
+  EXPECT_NE(std::string::npos, json.find("\"ph\":\"i\""));
+}
+
+TEST(TraceTest, FullBufferKeepsEarliestEvents) {
+  Trace::clear();
+  Trace::instant("first");
+  for (std::size_t i = 1; i < Trace::kEventsPerThread; ++i)
+    Trace::instant("filler");
+  Trace::instant("overflow");
+
+  const std::string json = exportTrace();
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"first\""));
+  EXPECT_EQ(std::string::npos, json.find("\"name\":\"overflow\""));
+}
+
+TEST(TraceTest, ClearDropsRecordedEvents) {
+  Trace::instant("before clear");
+  Trace::clear();
+  Trace::instant("after clear");
+
+  const std::string json = exportTrace();
+  EXPECT_EQ(std::string::npos, json.find("\"name\":\"before clear\""));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"after clear\""));
+}
+
+TEST(TraceTest, NegativeDurationStaysCompleteEvent) {
+  Trace::clear();
+  const Trace::Clock::time_point now = Trace::Clock::now();
+  Trace::complete("backwards", now, now - std::chrono::milliseconds(1));
+
+  const std::string json = exportTrace();
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"backwards\""));
+  EXPECT_NE(std::string::npos, json.find("\"ph\":\"X\",\"dur\":0"));
+  EXPECT_EQ(std::string::npos, json.find("\"ph\":\"i\""));
+}
+
+TEST(TraceTest, ExitedThreadBufferIsReused) {
+  Trace::clear();
+  std::thread([] { Trace::instant("reuse first"); }).join();
+  std::thread([] { Trace::instant("reuse second"); }).join();
+
+  const std::string json = exportTrace();
+  const auto tidOf = [&json](const std::string& name) {
+    const std::size_t at = json.find("\"name\":\"" + name + "\"");
+    EXPECT_NE(std::string::npos, at);
+    const std::size_t tid = json.find("\"tid\":", at);
+    return json.substr(tid, json.find(',', tid) - tid);
+  };
+  EXPECT_EQ(tidOf("reuse first"), tidOf("reuse second"));
+}
+
+TEST(TraceTest, ExportsWhileThreadsRecord) {
+  Trace::clear();
+  std::atomic<bool> stop{ false };
+  std::thread worker([&] {
+    while (!stop.load(std::memory_order_relaxed)) {
+      Trace::instant("busy");
+      Trace::clear();
+    }
+  });
+
+  for (int i = 0; i < 20; ++i)
+    EXPECT_EQ(0u, exportTrace().find("{\"traceEvents\":["));
+  stop.store(true, std::memory_order_relaxed);
+  worker.join();
+}
+
+TEST(LatencyHistogramTest, SmallValuesHaveExactBuckets) {
+  for (std::uint64_t v = 0; v < LatencyHistogram::kSubBuckets; ++v) {
+    EXPECT_EQ(v, LatencyHistogram::bucketIndex(v));
+    EXPECT_EQ(v, LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketIndex(v)));
+  }
+}
+
+TEST(LatencyHistogramTest, BucketBoundsRoundTrip) {
+  const std::uint64_t values[] = { 0, 31, 32, 33, 63, 64, 65, 127, 128, 1000, std::numeric_limits<std::uint64_t>::max() };
+  for (const std::uint64_t v : values) {
+    const std::size_t index = LatencyHistogram::bucketIndex(v);
+    const std::uint64_t upper = LatencyHistogram::bucketUpperBound(index);
+    EXPECT_LT(index, LatencyHistogram::kBucketCount) << v;
+    EXPECT_GE(upper, v) << v;
+    EXPECT_LE(upper - v, v / LatencyHistogram::kSubBuckets) << v;
+    EXPECT_EQ(index, LatencyHistogram::bucketIndex(upper)) << v;
+  }
+  EXPECT_EQ(LatencyHistogram::kBucketCount - 1,
+            LatencyHistogram::bucketIndex(std::numeric_limits<std::uint64_t>::max()));
+  EXPECT_EQ(32u, LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketIndex(32)));
+  EXPECT_EQ(65u, LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketIndex(64)));
+}
+
+TEST(LatencyHistogramTest, PercentilesOfUniformSamples) {
+  auto histogram = std::make_unique<LatencyHistogram>();
+  for (std::uint64_t v = 1; v <= 1000; ++v)
+    histogram->record(v);
+
+  EXPECT_EQ(1000u, histogram->count());
+  EXPECT_EQ(1000u, histogram->max());
+  EXPECT_GE(histogram->valueAtPercentile(50.0), 500u);
+  EXPECT_LE(histogram->valueAtPercentile(50.0), 500u + 500u / 32);
+  EXPECT_GE(histogram->valueAtPercentile(99.0), 990u);
+  EXPECT_LE(histogram->valueAtPercentile(99.0), 990u + 990u / 32);
+  EXPECT_EQ(1000u, histogram->valueAtPercentile(100.0));
+}
+
+TEST(LatencyHistogramTest, EmptyHistogramReportsZero) {
+  auto histogram = std::make_unique<LatencyHistogram>();
+  EXPECT_EQ(0u, histogram->count());
+  EXPECT_EQ(0u, histogram->max());
+  EXPECT_EQ(0u, histogram->valueAtPercentile(50.0));
+  EXPECT_EQ(0u, histogram->valueAtPercentile(99.9));
+}